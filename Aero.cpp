@@ -0,0 +1,94 @@
+
+#include <cmath>
+#include "Aero.hpp"
+
+//// Compile time math (C++11 constexpr: one return statement) ////
+
+namespace
+{
+	constexpr double 	cexpSeries( double x, double term, unsigned n, double sum ) {
+		return n > 32 ? sum : cexpSeries(x, term * x / n, n + 1, sum + term * x / n);
+	}
+	constexpr double 	cexp( double x ) { return cexpSeries(x, 1.0, 1, 1.0); }
+
+	// ln(y) = 2 * atanh((y - 1) / (y + 1)), converges fast for y close to 1
+	constexpr double 	clnSeries( double z2, double term, unsigned n, double sum ) {
+		return n > 41 ? sum : clnSeries(z2, term * z2, n + 2, sum + term * z2 / (n + 2));
+	}
+	constexpr double 	cln( double y ) {
+		return 2.0 * clnSeries(((y - 1.0) / (y + 1.0)) * ((y - 1.0) / (y + 1.0)),
+				(y - 1.0) / (y + 1.0), 1, (y - 1.0) / (y + 1.0));
+	}
+	constexpr double 	cpow( double b, double e ) { return cexp(e * cln(b)); }
+
+	//// International Standard Atmosphere ////
+	constexpr double 	ISA_T0 = 288.15;       // K, sea level
+	constexpr double 	ISA_P0 = 101325.0;     // Pa, sea level
+	constexpr double 	ISA_LAPSE = 0.0065;    // K/m, troposphere
+	constexpr double 	ISA_G = 9.80665;       // m/s2
+	constexpr double 	ISA_R = 287.05287;     // J/(kg.K), dry air
+	constexpr double 	ISA_H11 = 11000.0;     // m, tropopause
+	constexpr double 	ISA_T11 = ISA_T0 - ISA_LAPSE * ISA_H11;
+	constexpr double 	ISA_P11 = 22632.06;    // Pa, at the tropopause
+
+	constexpr double 	isaTemperature( double h ) {
+		return h < ISA_H11 ? ISA_T0 - ISA_LAPSE * h : ISA_T11;
+	}
+	constexpr double 	isaPressure( double h ) {
+		return h < ISA_H11
+			? ISA_P0 * cpow(isaTemperature(h) / ISA_T0, ISA_G / (ISA_R * ISA_LAPSE))
+			: ISA_P11 * cexp(-ISA_G * (h - ISA_H11) / (ISA_R * ISA_T11));
+	}
+	constexpr double 	isaDensity( double h ) {
+		return isaPressure(h) / (ISA_R * isaTemperature(h));
+	}
+
+	//// Table generation ////
+	template<unsigned... I> struct IndexSeq {};
+	template<unsigned N, unsigned... I> struct MakeIndexSeq : MakeIndexSeq<N - 1, N - 1, I...> {};
+	template<unsigned... I> struct MakeIndexSeq<0, I...> { using type = IndexSeq<I...>; };
+
+	constexpr unsigned 	ATMOS_N = Atmosphere::SAMPLES;
+	constexpr double 	ATMOS_STEP = Atmosphere::MAX_ALTITUDE / (ATMOS_N - 1);
+
+	// sample ATMOS_N is the padding copy of the last one
+	constexpr double 	atmosAltitude( unsigned i ) {
+		return ATMOS_STEP * (i < ATMOS_N ? i : ATMOS_N - 1);
+	}
+
+	template<unsigned... I>
+	constexpr LookupTable<ATMOS_N> 	makeDensityTable( IndexSeq<I...> ) {
+		return LookupTable<ATMOS_N>{ 0.f, float(1.0 / ATMOS_STEP),
+			{ float(isaDensity(atmosAltitude(I)))... } };
+	}
+
+	template<unsigned... I>
+	constexpr LookupTable<ATMOS_N> 	makePressureTable( IndexSeq<I...> ) {
+		return LookupTable<ATMOS_N>{ 0.f, float(1.0 / ATMOS_STEP),
+			{ float(isaPressure(atmosAltitude(I)))... } };
+	}
+}
+
+constexpr float 	Atmosphere::MAX_ALTITUDE;
+
+constexpr LookupTable<Atmosphere::SAMPLES> 	Atmosphere::density =
+	makeDensityTable(MakeIndexSeq<Atmosphere::SAMPLES + 1>::type());
+
+constexpr LookupTable<Atmosphere::SAMPLES> 	Atmosphere::pressure =
+	makePressureTable(MakeIndexSeq<Atmosphere::SAMPLES + 1>::type());
+
+
+AeroProfile 	AeroProfile::flatPlate( float liftCoeff, float dragCoeff )
+{
+	const float pi = 3.14159265f;
+	AeroProfile profile;
+
+	profile.lift = makeLookupTable<SAMPLES>(-pi, pi,
+			[liftCoeff]( float aoa ) { return liftCoeff * std::sin(2.f * aoa); });
+	profile.drag = makeLookupTable<SAMPLES>(-pi, pi,
+			[dragCoeff]( float aoa ) { return dragCoeff * std::abs(std::sin(aoa)); });
+	profile.moment = makeLookupTable<SAMPLES>(-pi, pi,
+			[]( float ) { return 0.f; });
+
+	return profile;
+}
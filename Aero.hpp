@@ -0,0 +1,78 @@
+#ifndef __MCPLANE_AERO_HPP__
+# define __MCPLANE_AERO_HPP__
+
+# include <algorithm>
+
+
+///
+/// Function sampled uniformly over [minX, minX + (N-1)/invStep].
+/// Lookups outside of the range are clamped to the first/last sample.
+/// `samples[N]` is a copy of the last sample so that the interpolation
+/// never has to test for the upper bound.
+///
+template<unsigned N>
+struct LookupTable
+{
+	float 	minX;
+	float 	invStep;
+	float 	samples[N + 1];
+
+	float 	operator()( float x ) const {
+		float t = std::min(std::max((x - minX) * invStep, 0.f), float(N - 1));
+		unsigned i = unsigned(t);
+		float frac = t - float(i);
+		return samples[i] + (samples[i + 1] - samples[i]) * frac;
+	}
+};
+
+/// Sample `f` over [minX, maxX] at runtime.
+template<unsigned N, class F>
+LookupTable<N> 	makeLookupTable( float minX, float maxX, F f )
+{
+	LookupTable<N> table;
+	float step = (maxX - minX) / float(N - 1);
+	table.minX = minX;
+	table.invStep = 1.f / step;
+	for (unsigned i = 0; i < N; ++i)
+		table.samples[i] = f(minX + step * float(i));
+	table.samples[N] = table.samples[N - 1];
+	return table;
+}
+
+
+///
+/// Per-surface aerodynamic coefficients as a function of the angle of attack
+/// (radians, [-pi, pi]). Forces are scaled by the dynamic pressure and the
+/// surface area, the moment also by the chord.
+///
+struct AeroProfile
+{
+	static const unsigned 	SAMPLES = 128;
+
+	LookupTable<SAMPLES> 	lift;
+	LookupTable<SAMPLES> 	drag;
+	LookupTable<SAMPLES> 	moment;
+
+	/// Thin flat plate: lift ~ sin(2*aoa), drag ~ |sin(aoa)|, no pitching moment.
+	static AeroProfile 	flatPlate( float liftCoeff, float dragCoeff );
+};
+
+
+///
+/// International Standard Atmosphere (troposphere and lower stratosphere),
+/// precomputed at compile time.
+///
+struct Atmosphere
+{
+	static const unsigned 	SAMPLES = 256;
+	static constexpr float 	MAX_ALTITUDE = 20000.f; // m
+
+	static const LookupTable<SAMPLES> 	density;  ///< kg/m3
+	static const LookupTable<SAMPLES> 	pressure; ///< Pa, or N/m2
+
+	static float 	getDensity( float altitude ) { return density(altitude); }
+	static float 	getPressure( float altitude ) { return pressure(altitude); }
+};
+
+
+#endif // __MCPLANE_AERO_HPP__
@@ -0,0 +1,45 @@
+#ifndef __MCPLANE_DRAWLIST_HPP__
+# define __MCPLANE_DRAWLIST_HPP__
+
+# include <vector>
+# include <algorithm>
+# include <cstdint>
+# include <glm/glm.hpp>
+# include "Mesh.hpp"
+
+
+using MaterialID = uint32_t;
+
+struct DrawItem
+{
+	uint64_t 	key;     ///< mesh in the high bits, material in the low bits
+	uint32_t 	matrix;  ///< index in DrawList::matrices
+
+	MeshID 		mesh( void ) const { return MeshID(key >> 32); }
+	MaterialID 	material( void ) const { return MaterialID(key & 0xffffffff); }
+};
+
+///
+/// Draws of one frame. Sorted by mesh then material so that Graphics::submit
+/// changes state as rarely as possible.
+///
+struct DrawList
+{
+	std::vector<DrawItem> 		items;
+	std::vector<glm::mat4> 		matrices;  ///< model matrices, filled by TransformStage
+
+	void 	clear( void ) { items.clear(); }
+
+	/// The n-th added item uses the n-th model matrix.
+	void 	add( MeshID mesh, MaterialID material ) {
+		items.push_back({ (uint64_t(mesh) << 32) | material, uint32_t(items.size()) });
+	}
+
+	void 	sort( void ) {
+		std::sort(items.begin(), items.end(),
+				[]( const DrawItem& a, const DrawItem& b ) { return a.key < b.key; });
+	}
+};
+
+
+#endif // __MCPLANE_DRAWLIST_HPP__
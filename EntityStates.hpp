@@ -0,0 +1,37 @@
+#ifndef __MCPLANE_ENTITYSTATES_HPP__
+# define __MCPLANE_ENTITYSTATES_HPP__
+
+# include <vector>
+# include <glm/glm.hpp>
+# include <glm/gtc/quaternion.hpp>
+
+
+///
+/// Structure of arrays snapshot of the entities' transforms, one index per entity.
+///
+struct EntityStates
+{
+	std::vector<int> 			ids;
+	std::vector<glm::vec3> 		positions;
+	std::vector<glm::quat> 		rotations;
+	std::vector<glm::vec3> 		scales;
+
+	size_t 	size( void ) const { return ids.size(); }
+
+	void 	clear( void ) {
+		ids.clear();
+		positions.clear();
+		rotations.clear();
+		scales.clear();
+	}
+
+	void 	push( int id, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale ) {
+		ids.push_back(id);
+		positions.push_back(position);
+		rotations.push_back(rotation);
+		scales.push_back(scale);
+	}
+};
+
+
+#endif // __MCPLANE_ENTITYSTATES_HPP__
@@ -13,8 +13,10 @@ const char* vertexShader = R"str(
 uniform mat4 proj;
 uniform mat4 view;
 uniform mat4 model;
+uniform vec3 boundsCenter;
+uniform vec3 boundsExtent;
 
-layout (location = 0) in vec3 Position;
+layout (location = 0) in vec3 Position; // normalized within the mesh bounds
 layout (location = 1) in vec3 Normal;
 
 out VS_OUT
@@ -26,13 +28,16 @@ void main() {
 	// direction of the sun
 	vec3 sunDir = normalize(vec3(0.5, 1, 0.25));
 
+	// model is translate * rotate * scale: the normal matrix, inverse transpose
+	// of its upper 3x3, is rotate * inverse(scale) = columns / squared lengths
 	mat4 rot = model;
-	rot[3][0] = 0;
-	rot[3][1] = 0;
-	rot[3][2] = 0;
-	vec3 N = normalize((rot*vec4(Normal, 1.0)).xyz);
+	rot[0] /= dot(rot[0].xyz, rot[0].xyz);
+	rot[1] /= dot(rot[1].xyz, rot[1].xyz);
+	rot[2] /= dot(rot[2].xyz, rot[2].xyz);
+	vec3 N = normalize((rot*vec4(Normal, 0.0)).xyz);
 	vs_out.light = max(dot(N, sunDir), 0.0);
-	gl_Position = proj * view * model * vec4(Position, 1.0);
+	vec3 P = boundsCenter + Position * boundsExtent;
+	gl_Position = proj * view * model * vec4(P, 1.0);
 }
 
 )str";
@@ -164,70 +169,11 @@ bool 	Graphics::init( unsigned width, unsigned height )
 	_unifView = glGetUniformLocation(_programId, "view");
 	_unifModel = glGetUniformLocation(_programId, "model");
 	_unifColor = glGetUniformLocation(_programId, "color");
+	_unifBoundsCenter = glGetUniformLocation(_programId, "boundsCenter");
+	_unifBoundsExtent = glGetUniformLocation(_programId, "boundsExtent");
 
 	// Generate a Box
-	glGenVertexArrays(1, &_boxVAO);
-	glBindVertexArray(_boxVAO);
-
-
-	// Create a Vertex Buffer Object and copy the vertex data to it
-	glGenBuffers(1, &_boxVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, _boxVBO);
-
-	GLfloat vertices[] = {
-		-0.5f,	-0.5f,	-0.5f,	0.0f,	0.0f,	-1.0f,	
-		0.5f,	-0.5f,	-0.5f,	0.0f,	0.0f,	-1.0f,	
-		0.5f,	 0.5f,	-0.5f,	0.0f,	0.0f,	-1.0f,	
-		0.5f,	 0.5f,	-0.5f,	0.0f,	0.0f,	-1.0f,	
-		-0.5f,	 0.5f,	-0.5f,	0.0f,	0.0f,	-1.0f,	
-		-0.5f,	-0.5f,	-0.5f,	0.0f,	0.0f,	-1.0f,	
-
-		-0.5f,	-0.5f,	 0.5f,	0.0f,	0.0f,	1.0f,	
-		0.5f,	-0.5f,	 0.5f,	0.0f,	0.0f,	1.0f,	
-		0.5f,	 0.5f,	 0.5f,	0.0f,	0.0f,	1.0f,	
-		0.5f,	 0.5f,	 0.5f,	0.0f,	0.0f,	1.0f,	
-		-0.5f,	 0.5f,	 0.5f,	0.0f,	0.0f,	1.0f,	
-		-0.5f,	-0.5f,	 0.5f,	0.0f,	0.0f,	1.0f,	
-
-		-0.5f,	 0.5f,	 0.5f,	-1.0f,	0.0f,	0.0f,	
-		-0.5f,	 0.5f,	-0.5f,	-1.0f,	0.0f,	0.0f,	
-		-0.5f,	-0.5f,	-0.5f,	-1.0f,	0.0f,	0.0f,	
-		-0.5f,	-0.5f,	-0.5f,	-1.0f,	0.0f,	0.0f,	
-		-0.5f,	-0.5f,	 0.5f,	-1.0f,	0.0f,	0.0f,	
-		-0.5f,	 0.5f,	 0.5f,	-1.0f,	0.0f,	0.0f,	
-
-		0.5f,	 0.5f,	 0.5f,	1.0f,	0.0f,	0.0f,	
-		0.5f,	 0.5f,	-0.5f,	1.0f,	0.0f,	0.0f,	
-		0.5f,	-0.5f,	-0.5f,	1.0f,	0.0f,	0.0f,	
-		0.5f,	-0.5f,	-0.5f,	1.0f,	0.0f,	0.0f,	
-		0.5f,	-0.5f,	 0.5f,	1.0f,	0.0f,	0.0f,	
-		0.5f,	 0.5f,	 0.5f,	1.0f,	0.0f,	0.0f,	
-
-		-0.5f,	-0.5f,	-0.5f,	0.0f,	-1.0f,	0.0f,	
-		0.5f,	-0.5f,	-0.5f,	0.0f,	-1.0f,	0.0f,	
-		0.5f,	-0.5f,	 0.5f,	0.0f,	-1.0f,	0.0f,	
-		0.5f,	-0.5f,	 0.5f,	0.0f,	-1.0f,	0.0f,	
-		-0.5f,	-0.5f,	 0.5f,	0.0f,	-1.0f,	0.0f,	
-		-0.5f,	-0.5f,	-0.5f,	0.0f,	-1.0f,	0.0f,	
-
-		-0.5f,	 0.5f,	-0.5f,	0.0f,	1.0f,	0.0f,	
-		0.5f,	 0.5f,	-0.5f,	0.0f,	1.0f,	0.0f,	
-		0.5f,	 0.5f,	 0.5f,	0.0f,	1.0f,	0.0f,	
-		0.5f,	 0.5f,	 0.5f,	0.0f,	1.0f,	0.0f,	
-		-0.5f,	 0.5f,	 0.5f,	0.0f,	1.0f,	0.0f,	
-		-0.5f,	 0.5f,	-0.5f,	0.0f,	1.0f,	0.0f
-	};
-
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-
-	
-	// Specify the layout of the vertex data
-	glEnableVertexAttribArray(0/*SHADER_ATTRIB_POSITION*/);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), 0);
-
-	glEnableVertexAttribArray(1/*SHADER_ATTRIB_NORMAL*/);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (void*)(3 * sizeof(GLfloat)));
+	_boxMesh = _meshes.get(MeshKey::box());
 
 	// Application Settings
 	mat4 	_proj = perspective( 3.14f/3.f, (float)width/(float)height, 0.1f, 1000.f);
@@ -247,8 +193,7 @@ void 	Graphics::deinit( void )
 	if (_fragId) glDeleteShader(_fragId);
 	if (_vertId) glDeleteShader(_vertId);
 	if (_programId) glDeleteProgram(_programId);
-	glDeleteBuffers(1, &_boxVBO);
-	glDeleteVertexArrays(1, &_boxVAO);
+	_meshes.clear();
 	_win.reset();
 }
 
@@ -259,11 +204,60 @@ void 	Graphics::clear( void )
 	glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
 }
 
+MeshID 	Graphics::getMesh( const MeshKey& key )
+{
+	return _meshes.get(key);
+}
+
 void 	Graphics::drawBox( const mat4& model, const Color& color )
 {
+	drawMesh(_boxMesh, model, color);
+}
+
+void 	Graphics::drawMesh( MeshID id, const mat4& model, const Color& color )
+{
+	const Mesh& mesh = _meshes[id];
+	glBindVertexArray(mesh.vao);
+	glUniform(_unifBoundsCenter, mesh.boundsCenter);
+	glUniform(_unifBoundsExtent, mesh.boundsExtent);
 	glUniform(_unifModel, model);
 	glUniform(_unifColor, color);
-	glDrawArrays(GL_TRIANGLES, 0, 36);
+	glDrawElements(GL_TRIANGLES, mesh.indexCount, mesh.indexType, 0);
+}
+
+MaterialID 	Graphics::addMaterial( const Color& color )
+{
+	_materials.push_back(color);
+	return MaterialID(_materials.size() - 1);
+}
+
+void 	Graphics::submit( const DrawList& list )
+{
+	MeshID mesh = ~MeshID(0);
+	MaterialID material = ~MaterialID(0);
+	GLsizei indexCount = 0;
+	GLenum indexType = GL_UNSIGNED_SHORT;
+
+	for (const DrawItem& item : list.items)
+	{
+		if (item.mesh() != mesh)
+		{
+			mesh = item.mesh();
+			const Mesh& m = _meshes[mesh];
+			glBindVertexArray(m.vao);
+			glUniform(_unifBoundsCenter, m.boundsCenter);
+			glUniform(_unifBoundsExtent, m.boundsExtent);
+			indexCount = m.indexCount;
+			indexType = m.indexType;
+		}
+		if (item.material() != material)
+		{
+			material = item.material();
+			glUniform(_unifColor, _materials[material]);
+		}
+		glUniform(_unifModel, list.matrices[item.matrix]);
+		glDrawElements(GL_TRIANGLES, indexCount, indexType, 0);
+	}
 }
 
 void 	Graphics::refresh( void )
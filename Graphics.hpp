@@ -14,6 +14,9 @@
 # include <glm/gtc/matrix_transform.hpp>	
 # include <glm/glm.hpp>
 # include <SDL2/SDL.h>
+# include <vector>
+# include "Mesh.hpp"
+# include "DrawList.hpp"
 
 
 using namespace glm;
@@ -70,15 +73,22 @@ class Graphics
 		void 	deinit( void );
 
 		void 	clear( void );
+		MeshID 	getMesh( const MeshKey& key );
 		void 	drawBox( const mat4& model, const Color& color );
+		void 	drawMesh( MeshID mesh, const mat4& model, const Color& color );
+
+		MaterialID 	addMaterial( const Color& color );
+		/// Draw a sorted DrawList, binding each mesh and material once.
+		void 		submit( const DrawList& list );
 		void 	refresh( void );
 
 	private:
 		SDLWindowUPtr 	_win = nullptr;
 		SDL_GLContext 	_context;
 
-		GLuint 			_boxVAO = 0;
-		GLuint 			_boxVBO = 0;
+		MeshRegistry 	_meshes;
+		MeshID 			_boxMesh = 0;
+		std::vector<Color> 	_materials;
 		GLuint  		_fragId     = 0;  ///< fragment shader id
 		GLuint  		_vertId     = 0;  ///< vertex shader id
 		GLuint  		_programId  = 0;  ///< program id (attaching both fragment and vertex shaders)
@@ -87,6 +97,8 @@ class Graphics
 		GLint 			_unifView = 0;
 		GLint 			_unifModel = 0;
 		GLint 			_unifColor = 0;
+		GLint 			_unifBoundsCenter = 0;
+		GLint 			_unifBoundsExtent = 0;
 
 		mat4 			_proj;
 		mat4 			_view;
@@ -0,0 +1,307 @@
+
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include "Mesh.hpp"
+
+using namespace glm;
+
+static const float 	PI = 3.14159265f;
+
+//// Packing ////
+
+static GLshort 	packSnorm16( float v )
+{
+	return GLshort(std::round(std::min(std::max(v, -1.f), 1.f) * 32767.f));
+}
+
+static GLuint 	packSnorm10( float v )
+{
+	return GLuint(GLint(std::round(std::min(std::max(v, -1.f), 1.f) * 511.f))) & 0x3ff;
+}
+
+/// GL_INT_2_10_10_10_REV: x in the low bits, w (unused) in the 2 high bits.
+static GLuint 	packNormal( const vec3& n )
+{
+	return packSnorm10(n.x) | (packSnorm10(n.y) << 10) | (packSnorm10(n.z) << 20);
+}
+
+//// MeshRegistry ////
+
+MeshID 	MeshRegistry::add( const MeshData& data )
+{
+	Mesh mesh;
+
+	// bounds, used to quantize the positions
+	vec3 lo(0.f), hi(0.f);
+	if (!data.positions.empty())
+	{
+		lo = hi = data.positions[0];
+		for (const vec3& p : data.positions)
+		{
+			lo = min(lo, p);
+			hi = max(hi, p);
+		}
+	}
+	mesh.boundsCenter = (lo + hi) * 0.5f;
+	mesh.boundsExtent = max((hi - lo) * 0.5f, vec3(1e-6f));
+
+	vec3 invExtent = 1.f / mesh.boundsExtent;
+	std::vector<PackedVertex> vertices(data.positions.size());
+	for (size_t i = 0; i < vertices.size(); ++i)
+	{
+		vec3 p = (data.positions[i] - mesh.boundsCenter) * invExtent;
+		vertices[i].position[0] = packSnorm16(p.x);
+		vertices[i].position[1] = packSnorm16(p.y);
+		vertices[i].position[2] = packSnorm16(p.z);
+		vertices[i].position[3] = 0;
+		vertices[i].normal = packNormal(normalize(data.normals[i]));
+	}
+
+	glGenVertexArrays(1, &mesh.vao);
+	glBindVertexArray(mesh.vao);
+
+	glGenBuffers(1, &mesh.vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(PackedVertex), vertices.data(), GL_STATIC_DRAW);
+
+	// Smallest index type able to address every vertex
+	glGenBuffers(1, &mesh.ibo);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
+	mesh.indexCount = GLsizei(data.indices.size());
+	if (vertices.size() <= 0x10000)
+	{
+		std::vector<GLushort> indices(data.indices.begin(), data.indices.end());
+		mesh.indexType = GL_UNSIGNED_SHORT;
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+	}
+	else
+	{
+		mesh.indexType = GL_UNSIGNED_INT;
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.indices.size() * sizeof(GLuint), data.indices.data(), GL_STATIC_DRAW);
+	}
+
+	// Specify the layout of the vertex data
+	glEnableVertexAttribArray(0/*SHADER_ATTRIB_POSITION*/);
+	glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, sizeof(PackedVertex),
+			(void*)offsetof(PackedVertex, position));
+
+	glEnableVertexAttribArray(1/*SHADER_ATTRIB_NORMAL*/);
+	glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(PackedVertex),
+			(void*)offsetof(PackedVertex, normal));
+
+	glBindVertexArray(0);
+
+	_meshes.push_back(mesh);
+	return MeshID(_meshes.size() - 1);
+}
+
+MeshID 	MeshRegistry::get( const MeshKey& key )
+{
+	auto it = _cache.find(key);
+	if (it != _cache.end())
+		return it->second;
+
+	MeshID id = add(generate(key));
+	_cache[key] = id;
+	return id;
+}
+
+void 	MeshRegistry::clear( void )
+{
+	for (Mesh& mesh : _meshes)
+	{
+		glDeleteBuffers(1, &mesh.vbo);
+		glDeleteBuffers(1, &mesh.ibo);
+		glDeleteVertexArrays(1, &mesh.vao);
+	}
+	_meshes.clear();
+	_cache.clear();
+}
+
+//// Shapes ////
+
+MeshData 	MeshRegistry::generate( const MeshKey& key )
+{
+	switch (key.shape)
+	{
+		case MeshShape::WING: 		return makeWing(key.segments);
+		case MeshShape::FUSELAGE: 	return makeFuselage(key.segments, key.param);
+		case MeshShape::TERRAIN: 	return makeTerrain(key.segments, key.param);
+		case MeshShape::BOX:
+		default: 					return makeBox();
+	}
+}
+
+MeshData 	MeshRegistry::makeBox( void )
+{
+	MeshData data;
+
+	// face normal, then two tangents with cross(u, v) == normal
+	const vec3 faces[6][3] = {
+		{ vec3( 1, 0, 0), vec3(0, 1, 0), vec3(0, 0, 1) },
+		{ vec3(-1, 0, 0), vec3(0, 0, 1), vec3(0, 1, 0) },
+		{ vec3( 0, 1, 0), vec3(0, 0, 1), vec3(1, 0, 0) },
+		{ vec3( 0,-1, 0), vec3(1, 0, 0), vec3(0, 0, 1) },
+		{ vec3( 0, 0, 1), vec3(1, 0, 0), vec3(0, 1, 0) },
+		{ vec3( 0, 0,-1), vec3(0, 1, 0), vec3(1, 0, 0) },
+	};
+
+	for (const auto& f : faces)
+	{
+		vec3 c = f[0] * 0.5f, u = f[1] * 0.5f, v = f[2] * 0.5f;
+		uint32_t a = data.addVertex(c - u - v, f[0]);
+		uint32_t b = data.addVertex(c + u - v, f[0]);
+		uint32_t d = data.addVertex(c + u + v, f[0]);
+		uint32_t e = data.addVertex(c - u + v, f[0]);
+		data.addQuad(a, b, d, e);
+	}
+	return data;
+}
+
+MeshData 	MeshRegistry::makeWing( uint32_t segments )
+{
+	MeshData data;
+	segments = std::max(segments, 2u);
+
+	// NACA 00xx half thickness at s in [0, 1] along the chord, scaled to fill y in [-0.5, 0.5]
+	auto thickness = []( float s ) {
+		return 5.f * (0.2969f * std::sqrt(s) - 0.1260f * s - 0.3516f * s*s + 0.2843f * s*s*s - 0.1036f * s*s*s*s);
+	};
+	auto slope = []( float s ) {
+		return 5.f * (0.2969f * 0.5f / std::sqrt(s) - 0.1260f - 0.7032f * s + 0.8529f * s*s - 0.4144f * s*s*s);
+	};
+
+	// chord stations, denser at the leading and trailing edges; the leading edge is forward (-z)
+	std::vector<vec2> profile(segments + 1); // (z, half thickness)
+	std::vector<float> slopes(segments + 1);
+	for (uint32_t i = 0; i <= segments; ++i)
+	{
+		float s = 0.5f * (1.f - std::cos(PI * float(i) / float(segments)));
+		profile[i] = vec2(s - 0.5f, thickness(s));
+		slopes[i] = (i == 0) ? 0.f : slope(s);
+	}
+
+	// upper and lower surfaces
+	for (float side : { 1.f, -1.f })
+	{
+		uint32_t first = uint32_t(data.positions.size());
+		for (uint32_t i = 0; i <= segments; ++i)
+		{
+			vec3 n = (i == 0) ? vec3(0, 0, -1) : vec3(0, side, -slopes[i]);
+			data.addVertex(vec3(-0.5f, side * profile[i].y, profile[i].x), n);
+			data.addVertex(vec3( 0.5f, side * profile[i].y, profile[i].x), n);
+		}
+		for (uint32_t i = 0; i < segments; ++i)
+		{
+			uint32_t a = first + 2 * i, b = a + 2, c = a + 3, d = a + 1;
+			if (side > 0.f)
+				data.addQuad(a, b, c, d);
+			else
+				data.addQuad(d, c, b, a);
+		}
+	}
+
+	// tips: fan around a point inside the (convex) profile
+	for (float side : { 1.f, -1.f })
+	{
+		vec3 n(side, 0, 0);
+		uint32_t center = data.addVertex(vec3(side * 0.5f, 0.f, -0.2f), n);
+		uint32_t first = uint32_t(data.positions.size());
+		for (uint32_t i = 0; i <= segments; ++i)
+			data.addVertex(vec3(side * 0.5f, profile[i].y, profile[i].x), n);
+		for (uint32_t i = segments; i > 0; --i)
+			data.addVertex(vec3(side * 0.5f, -profile[i].y, profile[i].x), n);
+
+		uint32_t count = 2 * segments + 1;
+		for (uint32_t k = 0; k < count; ++k)
+		{
+			uint32_t p = first + k, q = first + (k + 1) % count;
+			if (side > 0.f)
+				data.addTriangle(center, p, q);
+			else
+				data.addTriangle(center, q, p);
+		}
+	}
+	return data;
+}
+
+MeshData 	MeshRegistry::makeFuselage( uint32_t segments, float taper )
+{
+	MeshData data;
+	segments = std::max(segments, 3u);
+
+	float front = 0.5f;          // radius at the nose (z = -0.5)
+	float back = 0.5f * taper;   // radius at the tail (z = 0.5)
+	float dr = back - front;     // radius slope along z
+
+	// side
+	for (uint32_t j = 0; j < segments; ++j)
+	{
+		float a = 2.f * PI * float(j) / float(segments);
+		vec2 dir(std::cos(a), std::sin(a));
+		vec3 n(dir.x, dir.y, -dr);
+		data.addVertex(vec3(dir * front, -0.5f), n);
+		data.addVertex(vec3(dir * back, 0.5f), n);
+	}
+	for (uint32_t j = 0; j < segments; ++j)
+	{
+		uint32_t k = (j + 1) % segments;
+		data.addQuad(2 * j, 2 * k, 2 * k + 1, 2 * j + 1);
+	}
+
+	// nose and tail caps
+	for (float side : { -1.f, 1.f })
+	{
+		float radius = (side < 0.f) ? front : back;
+		vec3 n(0, 0, side);
+		uint32_t center = data.addVertex(vec3(0.f, 0.f, side * 0.5f), n);
+		uint32_t first = uint32_t(data.positions.size());
+		for (uint32_t j = 0; j < segments; ++j)
+		{
+			float a = 2.f * PI * float(j) / float(segments);
+			data.addVertex(vec3(std::cos(a) * radius, std::sin(a) * radius, side * 0.5f), n);
+		}
+		for (uint32_t j = 0; j < segments; ++j)
+		{
+			uint32_t p = first + j, q = first + (j + 1) % segments;
+			if (side > 0.f)
+				data.addTriangle(center, p, q);
+			else
+				data.addTriangle(center, q, p);
+		}
+	}
+	return data;
+}
+
+MeshData 	MeshRegistry::makeTerrain( uint32_t segments, float height )
+{
+	MeshData data;
+	segments = std::max(segments, 1u);
+
+	// two waves per side
+	const float k = 4.f * PI;
+	for (uint32_t i = 0; i <= segments; ++i)
+	{
+		for (uint32_t j = 0; j <= segments; ++j)
+		{
+			float x = float(i) / float(segments) - 0.5f;
+			float z = float(j) / float(segments) - 0.5f;
+			float y = height * std::sin(k * x) * std::cos(k * z);
+			float dydx = height * k * std::cos(k * x) * std::cos(k * z);
+			float dydz = -height * k * std::sin(k * x) * std::sin(k * z);
+			data.addVertex(vec3(x, y, z), vec3(-dydx, 1.f, -dydz));
+		}
+	}
+
+	uint32_t row = segments + 1;
+	for (uint32_t i = 0; i < segments; ++i)
+	{
+		for (uint32_t j = 0; j < segments; ++j)
+		{
+			uint32_t a = i * row + j;
+			data.addQuad(a, a + 1, a + row + 1, a + row);
+		}
+	}
+	return data;
+}
@@ -0,0 +1,125 @@
+#ifndef __MCPLANE_MESH_HPP__
+# define __MCPLANE_MESH_HPP__
+
+# include <map>
+# include <vector>
+# include <cstdint>
+# define GLEW_STATIC
+# include <GL/glew.h>
+# include <glm/glm.hpp>
+
+
+using MeshID = uint32_t;
+
+///
+/// Procedural shapes, all fitting the unit cube [-0.5, 0.5] (forward is -z)
+/// so that the entity scale gives their size.
+///
+enum class MeshShape : uint8_t
+{
+	BOX,
+	WING,       ///< symmetric NACA airfoil extruded along x, `segments` chordwise
+	FUSELAGE,   ///< cylinder along z, `segments` around, tail radius scaled by `param`
+	TERRAIN,    ///< height field grid on xz, `segments` per side, waves of height `param`
+};
+
+///
+/// Shape parameters, used as the key of the mesh cache.
+///
+struct MeshKey
+{
+	MeshShape 	shape;
+	uint32_t 	segments;
+	float 		param;
+
+	MeshKey( MeshShape shape = MeshShape::BOX, uint32_t segments = 1, float param = 0.f )
+		: shape(shape), segments(segments), param(param) {}
+
+	bool 	operator<( const MeshKey& other ) const {
+		if (shape != other.shape) return shape < other.shape;
+		if (segments != other.segments) return segments < other.segments;
+		return param < other.param;
+	}
+
+	static MeshKey 	box( void ) { return MeshKey(); }
+	static MeshKey 	wing( uint32_t segments ) { return MeshKey(MeshShape::WING, segments); }
+	static MeshKey 	fuselage( uint32_t segments, float taper ) { return MeshKey(MeshShape::FUSELAGE, segments, taper); }
+	static MeshKey 	terrain( uint32_t segments, float height ) { return MeshKey(MeshShape::TERRAIN, segments, height); }
+};
+
+///
+/// Mesh before packing, as generated on the CPU.
+///
+struct MeshData
+{
+	std::vector<glm::vec3> 		positions;
+	std::vector<glm::vec3> 		normals;
+	std::vector<uint32_t> 		indices;   ///< triangles, counter clockwise
+
+	uint32_t 	addVertex( const glm::vec3& p, const glm::vec3& n ) {
+		positions.push_back(p);
+		normals.push_back(n);
+		return uint32_t(positions.size() - 1);
+	}
+	void 		addTriangle( uint32_t a, uint32_t b, uint32_t c ) {
+		indices.push_back(a);
+		indices.push_back(b);
+		indices.push_back(c);
+	}
+	void 		addQuad( uint32_t a, uint32_t b, uint32_t c, uint32_t d ) {
+		addTriangle(a, b, c);
+		addTriangle(c, d, a);
+	}
+};
+
+///
+/// Packed vertex (12 bytes): int16 normalized position within the mesh bounds,
+/// GL_INT_2_10_10_10_REV normal.
+///
+struct PackedVertex
+{
+	GLshort 	position[4]; ///< xyz, w is padding
+	GLuint 		normal;
+};
+
+///
+/// Indexed mesh uploaded to the GPU. Positions are decoded in the vertex
+/// shader with `boundsCenter + Position * boundsExtent`.
+///
+struct Mesh
+{
+	GLuint 		vao = 0;
+	GLuint 		vbo = 0;
+	GLuint 		ibo = 0;
+	GLsizei 	indexCount = 0;
+	GLenum 		indexType = GL_UNSIGNED_SHORT;
+	glm::vec3 	boundsCenter;
+	glm::vec3 	boundsExtent;  ///< half size
+};
+
+///
+/// Own the GPU meshes and cache the procedural ones by shape parameters.
+/// Needs a current OpenGL context.
+///
+class MeshRegistry
+{
+	public:
+		MeshID 		add( const MeshData& data );
+		MeshID 		get( const MeshKey& key );
+		void 		clear( void );
+
+		const Mesh& 	operator[]( MeshID id ) const { return _meshes[id]; }
+
+		static MeshData 	generate( const MeshKey& key );
+		static MeshData 	makeBox( void );
+		static MeshData 	makeWing( uint32_t segments );
+		static MeshData 	makeFuselage( uint32_t segments, float taper );
+		static MeshData 	makeTerrain( uint32_t segments, float height );
+
+	private:
+		std::vector<Mesh> 				_meshes;
+		std::map<MeshKey, MeshID> 		_cache;
+};
+
+
+#endif // __MCPLANE_MESH_HPP__
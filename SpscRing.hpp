@@ -0,0 +1,54 @@
+#ifndef __MCPLANE_SPSCRING_HPP__
+# define __MCPLANE_SPSCRING_HPP__
+
+# include <atomic>
+# include <cstddef>
+
+
+///
+/// Lock-free ring buffer for exactly one producer thread and one consumer thread.
+/// N must be a power of two. push() fails (returns false) when the ring is full.
+///
+template<class T, size_t N>
+class SpscRing
+{
+	static_assert(N && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+	public:
+		bool 	push( const T& value ) {
+			size_t head = _head.load(std::memory_order_relaxed);
+			if (head - _tailCache == N)
+			{
+				_tailCache = _tail.load(std::memory_order_acquire);
+				if (head - _tailCache == N)
+					return false;
+			}
+			_items[head & (N - 1)] = value;
+			_head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool 	pop( T& value ) {
+			size_t tail = _tail.load(std::memory_order_relaxed);
+			if (tail == _headCache)
+			{
+				_headCache = _head.load(std::memory_order_acquire);
+				if (tail == _headCache)
+					return false;
+			}
+			value = _items[tail & (N - 1)];
+			_tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+	private:
+		// producer and consumer indices live on separate cache lines
+		alignas(64) std::atomic<size_t> 	_head{0};
+		size_t 								_tailCache = 0; ///< producer's copy of _tail
+		alignas(64) std::atomic<size_t> 	_tail{0};
+		size_t 								_headCache = 0; ///< consumer's copy of _head
+		alignas(64) T 						_items[N];
+};
+
+
+#endif // __MCPLANE_SPSCRING_HPP__
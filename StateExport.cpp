@@ -0,0 +1,188 @@
+
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sched.h>
+#include "StateExport.hpp"
+
+size_t 	SharedStateHeader::segmentSize( uint32_t capacity )
+{
+	return sizeof(SharedStateHeader)
+		+ capacity * (sizeof(int32_t) + 2 * sizeof(glm::vec3) + sizeof(glm::quat));
+}
+
+//// StateExport ////
+
+bool 	StateExport::open( const std::string& name, uint32_t capacity )
+{
+	if (_shared)
+		return false; // already open
+
+	int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+	if (fd < 0)
+	{
+		std::cout << "StateExport: shm_open failed for " << name << ": " << strerror(errno) << std::endl;
+		return false;
+	}
+
+	size_t size = SharedStateHeader::segmentSize(capacity);
+	if (ftruncate(fd, size) < 0)
+	{
+		std::cout << "StateExport: ftruncate failed: " << strerror(errno) << std::endl;
+		::close(fd);
+		shm_unlink(name.c_str());
+		return false;
+	}
+
+	void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (ptr == MAP_FAILED)
+	{
+		std::cout << "StateExport: mmap failed: " << strerror(errno) << std::endl;
+		shm_unlink(name.c_str());
+		return false;
+	}
+
+	_name = name;
+	_size = size;
+	_shared = (SharedStateHeader*)ptr;
+
+	// readers ignore the segment until the magic is set and a step is published
+	_shared->magic = 0;
+	_shared->version = SharedStateHeader::VERSION;
+	_shared->capacity = capacity;
+	_shared->sequence.store(0, std::memory_order_relaxed);
+	_shared->count = 0;
+	_shared->step = 0;
+	std::atomic_thread_fence(std::memory_order_release);
+	_shared->magic = SharedStateHeader::MAGIC;
+
+	return true;
+}
+
+void 	StateExport::close( void )
+{
+	if (!_shared)
+		return;
+
+	munmap(_shared, _size);
+	shm_unlink(_name.c_str());
+	_shared = nullptr;
+	_size = 0;
+}
+
+void 	StateExport::publish( const EntityStates& states, uint32_t step )
+{
+	if (!_shared)
+		return;
+
+	uint32_t count = std::min<size_t>(states.size(), _shared->capacity);
+	uint32_t seq = _shared->sequence.load(std::memory_order_relaxed);
+
+	_shared->sequence.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	_shared->count = count;
+	_shared->step = step;
+	std::copy_n(states.ids.begin(), count, _shared->ids());
+	std::copy_n(states.positions.begin(), count, _shared->positions());
+	std::copy_n(states.rotations.begin(), count, _shared->rotations());
+	std::copy_n(states.scales.begin(), count, _shared->scales());
+
+	_shared->sequence.store(seq + 2, std::memory_order_release);
+}
+
+//// StateExportReader ////
+
+bool 	StateExportReader::open( const std::string& name )
+{
+	if (_shared)
+		return false; // already open
+
+	int fd = shm_open(name.c_str(), O_RDONLY, 0);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(SharedStateHeader))
+	{
+		::close(fd);
+		return false;
+	}
+
+	void* ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (ptr == MAP_FAILED)
+		return false;
+
+	_shared = (const SharedStateHeader*)ptr;
+	_size = st.st_size;
+
+	if (_shared->magic != SharedStateHeader::MAGIC
+			|| _shared->version != SharedStateHeader::VERSION
+			|| SharedStateHeader::segmentSize(_shared->capacity) > _size)
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+void 	StateExportReader::close( void )
+{
+	if (!_shared)
+		return;
+
+	munmap((void*)_shared, _size);
+	_shared = nullptr;
+	_size = 0;
+}
+
+bool 	StateExportReader::beginRead( uint32_t& sequence ) const
+{
+	if (!_shared)
+		return false;
+
+	for (unsigned retry = 0; retry < MAX_RETRIES; ++retry)
+	{
+		sequence = _shared->sequence.load(std::memory_order_acquire);
+		if (sequence == 0)
+			return false; // nothing published yet
+		if ((sequence & 1) == 0)
+			return true;
+		sched_yield(); // write in progress
+	}
+	return false;
+}
+
+bool 	StateExportReader::endRead( uint32_t sequence ) const
+{
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return _shared->sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+bool 	StateExportReader::read( EntityStates& states, uint32_t& step ) const
+{
+	for (unsigned retry = 0; retry < MAX_RETRIES; ++retry)
+	{
+		uint32_t seq;
+		if (!beginRead(seq))
+			return false;
+
+		uint32_t count = std::min(_shared->count, _shared->capacity);
+		states.ids.assign(_shared->ids(), _shared->ids() + count);
+		states.positions.assign(_shared->positions(), _shared->positions() + count);
+		states.rotations.assign(_shared->rotations(), _shared->rotations() + count);
+		states.scales.assign(_shared->scales(), _shared->scales() + count);
+		step = _shared->step;
+
+		if (endRead(seq))
+			return true;
+	}
+	return false;
+}
@@ -0,0 +1,91 @@
+#ifndef __MCPLANE_STATEEXPORT_HPP__
+# define __MCPLANE_STATEEXPORT_HPP__
+
+# include <atomic>
+# include <cstdint>
+# include <string>
+# include "EntityStates.hpp"
+
+
+///
+/// Layout of the shared memory segment: this header followed by the arrays
+/// ids[capacity], positions[capacity], rotations[capacity], scales[capacity].
+/// `sequence` is a seqlock: odd while the simulation is writing a step.
+///
+struct SharedStateHeader
+{
+	static const uint32_t 	MAGIC = 0x4d435353; // "MCSS"
+	static const uint32_t 	VERSION = 1;
+
+	uint32_t 				magic;
+	uint32_t 				version;
+	uint32_t 				capacity;
+	std::atomic<uint32_t> 	sequence;
+	uint32_t 				count;
+	uint32_t 				step;
+
+	static size_t 	segmentSize( uint32_t capacity );
+
+	int32_t* 		ids( void ) { return (int32_t*)(this + 1); }
+	glm::vec3* 		positions( void ) { return (glm::vec3*)(ids() + capacity); }
+	glm::quat* 		rotations( void ) { return (glm::quat*)(positions() + capacity); }
+	glm::vec3* 		scales( void ) { return (glm::vec3*)(rotations() + capacity); }
+
+	const int32_t* 		ids( void ) const { return (const int32_t*)(this + 1); }
+	const glm::vec3* 	positions( void ) const { return (const glm::vec3*)(ids() + capacity); }
+	const glm::quat* 	rotations( void ) const { return (const glm::quat*)(positions() + capacity); }
+	const glm::vec3* 	scales( void ) const { return (const glm::vec3*)(rotations() + capacity); }
+};
+
+///
+/// Publish the entity states of each step to a POSIX shared memory segment
+/// (simulation side, single writer).
+///
+class StateExport
+{
+	public:
+		~StateExport( void ) { close(); }
+
+		bool 	open( const std::string& name, uint32_t capacity );
+		void 	close( void );
+
+		/// Entities beyond the capacity are not exported.
+		void 	publish( const EntityStates& states, uint32_t step );
+
+	private:
+		std::string 			_name;
+		SharedStateHeader* 		_shared = nullptr;
+		size_t 					_size = 0;
+};
+
+///
+/// Read-only view of a segment published by StateExport (viewer side).
+///
+class StateExportReader
+{
+	public:
+		~StateExportReader( void ) { close(); }
+
+		bool 	open( const std::string& name );
+		void 	close( void );
+
+		static const unsigned 	MAX_RETRIES = 64;
+
+		/// Copy a consistent snapshot. Returns false if nothing was published yet,
+		/// or if the writer stayed inside a step (e.g. it died while publishing).
+		bool 	read( EntityStates& states, uint32_t& step ) const;
+
+		/// Zero-copy reads: read the arrays of shared() in place between
+		/// beginRead() and endRead(); the data is only valid if endRead() returns true.
+		bool 	beginRead( uint32_t& sequence ) const;
+		bool 	endRead( uint32_t sequence ) const;
+
+		const SharedStateHeader* 	shared( void ) const { return _shared; }
+
+	private:
+		const SharedStateHeader* 	_shared = nullptr;
+		size_t 					_size = 0;
+};
+
+
+#endif // __MCPLANE_STATEEXPORT_HPP__
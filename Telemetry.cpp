@@ -0,0 +1,157 @@
+
+#include <iostream>
+#include <algorithm>
+#include <fstream>
+#include <chrono>
+#include "Telemetry.hpp"
+
+using namespace physx;
+
+static const char 		LOG_MAGIC[4] = { 'M', 'C', 'P', 'T' };
+static const uint32_t 	LOG_VERSION = 1;
+
+bool 	Telemetry::start( const std::string& logPath )
+{
+	if (_running)
+		return false; // already started
+
+	_logPath = logPath;
+	_running = true;
+	_consumer = std::thread(&Telemetry::consume, this);
+	return true;
+}
+
+void 	Telemetry::stop( void )
+{
+	if (!_running)
+		return;
+
+	_running = false;
+	_consumer.join();
+
+	std::cout << "Telemetry: " << _step << " steps, "
+		<< _dropped << " dropped events" << std::endl;
+	for (size_t i = 0; i < _stats.size() && i < _joints.size(); ++i)
+	{
+		const JointStats& s = _stats[i];
+		std::cout << "  joint " << i << " (" << _joints[i].eidA << " - " << _joints[i].eidB << ")"
+			<< " max force: " << s.maxForce
+			<< " mean force: " << (s.samples ? s.sumForce / s.samples : 0.0)
+			<< " max torque: " << s.maxTorque;
+		if (s.broken)
+			std::cout << " BROKEN at step " << s.breakStep;
+		std::cout << std::endl;
+	}
+}
+
+uint16_t 	Telemetry::addJoint( PxJoint* joint, int eidA, int eidB )
+{
+	joint->setConstraintFlag(PxConstraintFlag::eREPORTING, true);
+	_joints.push_back({ joint, eidA, eidB });
+	return uint16_t(_joints.size() - 1);
+}
+
+void 	Telemetry::push( const JointEvent& ev )
+{
+	if (!_ring.push(ev))
+		_dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void 	Telemetry::collect( void )
+{
+	for (size_t i = 0; i < _joints.size(); ++i)
+	{
+		PxConstraint* constraint = _joints[i].joint->getConstraint();
+		if (constraint->getFlags() & PxConstraintFlag::eBROKEN)
+			continue;
+
+		PxVec3 force, torque;
+		constraint->getForce(force, torque);
+
+		JointEvent ev = { _step, uint16_t(i), JointEvent::FORCE,
+			{ force.x, force.y, force.z }, { torque.x, torque.y, torque.z } };
+		push(ev);
+	}
+	++_step;
+}
+
+void 	Telemetry::onConstraintBreak( PxConstraintInfo* constraints, PxU32 count )
+{
+	// called from fetchResults, on the simulation thread
+	for (PxU32 c = 0; c < count; ++c)
+	{
+		if (constraints[c].type != PxConstraintExtIDs::eJOINT)
+			continue;
+
+		for (size_t i = 0; i < _joints.size(); ++i)
+		{
+			if (_joints[i].joint != constraints[c].externalReference)
+				continue;
+
+			JointEvent ev = { _step, uint16_t(i), JointEvent::BREAK, { 0.f, 0.f, 0.f }, { 0.f, 0.f, 0.f } };
+			push(ev);
+			break;
+		}
+	}
+}
+
+void 	Telemetry::consume( void )
+{
+	std::ofstream logFile;
+	if (!_logPath.empty())
+	{
+		logFile.open(_logPath, std::ios::binary | std::ios::trunc);
+		if (!logFile)
+			std::cout << "Telemetry: unable to open " << _logPath << std::endl;
+		else
+		{
+			uint32_t recordSize = sizeof(JointEvent);
+			logFile.write(LOG_MAGIC, sizeof(LOG_MAGIC));
+			logFile.write((const char*)&LOG_VERSION, sizeof(LOG_VERSION));
+			logFile.write((const char*)&recordSize, sizeof(recordSize));
+		}
+	}
+
+	JointEvent batch[256];
+	while (true)
+	{
+		// read the flag before draining so the last events are never lost
+		bool running = _running;
+
+		size_t n = 0;
+		while (n < 256 && _ring.pop(batch[n]))
+			++n;
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			const JointEvent& ev = batch[i];
+			if (ev.joint >= _stats.size())
+				_stats.resize(ev.joint + 1);
+
+			JointStats& s = _stats[ev.joint];
+			if (ev.type == JointEvent::BREAK)
+			{
+				s.broken = true;
+				s.breakStep = ev.step;
+				continue;
+			}
+
+			float force = PxVec3(ev.force[0], ev.force[1], ev.force[2]).magnitude();
+			float torque = PxVec3(ev.torque[0], ev.torque[1], ev.torque[2]).magnitude();
+			s.maxForce = std::max(s.maxForce, force);
+			s.maxTorque = std::max(s.maxTorque, torque);
+			s.sumForce += force;
+			++s.samples;
+		}
+
+		if (logFile.is_open() && n)
+			logFile.write((const char*)batch, n * sizeof(JointEvent));
+
+		if (n == 0)
+		{
+			if (!running)
+				break;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+}
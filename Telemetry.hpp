@@ -0,0 +1,92 @@
+#ifndef __MCPLANE_TELEMETRY_HPP__
+# define __MCPLANE_TELEMETRY_HPP__
+
+# include <atomic>
+# include <cstdint>
+# include <string>
+# include <thread>
+# include <vector>
+# include <PxPhysicsAPI.h>
+# include "SpscRing.hpp"
+
+
+///
+/// One joint sample, written as-is (32 bytes) to the binary log.
+///
+struct JointEvent
+{
+	enum Type : uint16_t { FORCE = 0, BREAK = 1 };
+
+	uint32_t 	step;
+	uint16_t 	joint;      ///< index given by Telemetry::addJoint
+	uint16_t 	type;
+	float 		force[3];   ///< world space linear force (N)
+	float 		torque[3];  ///< world space angular force (N.m)
+};
+
+///
+/// Collect joint forces and break events on the simulation thread and hand
+/// them to a consumer thread which aggregates them and writes a binary log.
+/// The simulation thread never blocks: events are dropped when the ring is full.
+///
+class Telemetry : public physx::PxSimulationEventCallback
+{
+	public:
+		static const size_t 	RING_SIZE = 1 << 14;
+
+		~Telemetry( void ) { stop(); }
+
+		/// Start the consumer thread. An empty path only aggregates.
+		bool 	start( const std::string& logPath );
+		void 	stop( void );
+
+		uint16_t 	addJoint( physx::PxJoint* joint, int eidA, int eidB );
+
+		/// Sample the forces of every joint. Call after fetchResults.
+		void 	collect( void );
+
+		// PxSimulationEventCallback
+		void 	onConstraintBreak( physx::PxConstraintInfo* constraints, physx::PxU32 count ) override;
+		void 	onWake( physx::PxActor**, physx::PxU32 ) override {}
+		void 	onSleep( physx::PxActor**, physx::PxU32 ) override {}
+		void 	onContact( const physx::PxContactPairHeader&, const physx::PxContactPair*, physx::PxU32 ) override {}
+		void 	onTrigger( physx::PxTriggerPair*, physx::PxU32 ) override {}
+
+	private:
+		struct Joint
+		{
+			physx::PxJoint* 	joint;
+			int 				eidA;
+			int 				eidB;
+		};
+
+		struct JointStats
+		{
+			uint32_t 	samples = 0;
+			uint32_t 	breakStep = 0;
+			bool 		broken = false;
+			float 		maxForce = 0.f;
+			float 		maxTorque = 0.f;
+			double 		sumForce = 0.0;
+		};
+
+		void 	push( const JointEvent& ev );
+		void 	consume( void );
+
+		// simulation thread
+		std::vector<Joint> 					_joints;
+		uint32_t 							_step = 0;
+
+		// shared
+		SpscRing<JointEvent, RING_SIZE> 	_ring;
+		std::atomic<bool> 					_running{false};
+		std::atomic<uint64_t> 				_dropped{0};
+		std::thread 						_consumer;
+
+		// consumer thread
+		std::string 						_logPath;
+		std::vector<JointStats> 			_stats;
+};
+
+
+#endif // __MCPLANE_TELEMETRY_HPP__
@@ -0,0 +1,159 @@
+
+#include <algorithm>
+#include "Transform.hpp"
+
+#ifdef __SSE__
+# include <xmmintrin.h>
+#endif
+
+using namespace glm;
+
+void 	computeModelMatrices( const vec3* positions, const quat* rotations,
+		const vec3* scales, mat4* out, size_t count )
+{
+	size_t i = 0;
+
+#ifdef __SSE__
+	// Each lane is an entity: gather the inputs, compute the 12 non constant
+	// entries, then transpose them back into four column major matrices.
+	const __m128 one = _mm_set1_ps(1.f);
+	const __m128 two = _mm_set1_ps(2.f);
+	for (; i + 4 <= count; i += 4)
+	{
+		const quat* q = rotations + i;
+		const vec3* p = positions + i;
+		const vec3* s = scales + i;
+
+		__m128 qx = _mm_set_ps(q[3].x, q[2].x, q[1].x, q[0].x);
+		__m128 qy = _mm_set_ps(q[3].y, q[2].y, q[1].y, q[0].y);
+		__m128 qz = _mm_set_ps(q[3].z, q[2].z, q[1].z, q[0].z);
+		__m128 qw = _mm_set_ps(q[3].w, q[2].w, q[1].w, q[0].w);
+		__m128 sx = _mm_set_ps(s[3].x, s[2].x, s[1].x, s[0].x);
+		__m128 sy = _mm_set_ps(s[3].y, s[2].y, s[1].y, s[0].y);
+		__m128 sz = _mm_set_ps(s[3].z, s[2].z, s[1].z, s[0].z);
+
+		__m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+		__m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+		__m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+		__m128 col[4][4];
+		col[0][0] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+		col[0][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+		col[0][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+		col[0][3] = _mm_setzero_ps();
+		col[1][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+		col[1][1] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+		col[1][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+		col[1][3] = _mm_setzero_ps();
+		col[2][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+		col[2][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+		col[2][2] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+		col[2][3] = _mm_setzero_ps();
+		col[3][0] = _mm_set_ps(p[3].x, p[2].x, p[1].x, p[0].x);
+		col[3][1] = _mm_set_ps(p[3].y, p[2].y, p[1].y, p[0].y);
+		col[3][2] = _mm_set_ps(p[3].z, p[2].z, p[1].z, p[0].z);
+		col[3][3] = one;
+
+		for (int c = 0; c < 4; ++c)
+		{
+			_MM_TRANSPOSE4_PS(col[c][0], col[c][1], col[c][2], col[c][3]);
+			for (int e = 0; e < 4; ++e)
+				_mm_storeu_ps(&out[i + e][c][0], col[c][e]);
+		}
+	}
+#endif
+
+	for (; i < count; ++i)
+		out[i] = composeModelMatrix(positions[i], rotations[i], scales[i]);
+}
+
+//// TransformStage ////
+
+unsigned 	TransformStage::defaultWorkers( void )
+{
+	return std::max(std::thread::hardware_concurrency(), 1u) - 1;
+}
+
+TransformStage::TransformStage( unsigned workers )
+	: _workers(workers)
+{
+}
+
+TransformStage::~TransformStage( void )
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_startCond.notify_all();
+	for (std::thread& t : _threads)
+		t.join();
+}
+
+void 	TransformStage::compute( const EntityStates& states, std::vector<mat4>& matrices )
+{
+	matrices.resize(states.size());
+	_states = &states;
+	_out = matrices.data();
+
+	if (_workers == 0 || states.size() < PARALLEL_THRESHOLD)
+	{
+		computeModelMatrices(states.positions.data(), states.rotations.data(),
+				states.scales.data(), _out, states.size());
+		return;
+	}
+
+	if (_threads.empty())
+	{
+		for (unsigned i = 0; i < _workers; ++i)
+			_threads.emplace_back(&TransformStage::work, this, i + 1);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_pending = unsigned(_threads.size());
+		++_generation;
+	}
+	_startCond.notify_all();
+
+	computeChunk(0);
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_doneCond.wait(lock, [this] { return _pending == 0; });
+}
+
+void 	TransformStage::computeChunk( unsigned index )
+{
+	// chunks are multiples of 4 so that only the last one has a scalar tail
+	size_t count = _states->size();
+	size_t chunks = _threads.size() + 1;
+	size_t chunkSize = ((count + chunks - 1) / chunks + 3) & ~size_t(3);
+	size_t begin = std::min(count, index * chunkSize);
+	size_t end = std::min(count, begin + chunkSize);
+
+	computeModelMatrices(_states->positions.data() + begin, _states->rotations.data() + begin,
+			_states->scales.data() + begin, _out + begin, end - begin);
+}
+
+void 	TransformStage::work( unsigned index )
+{
+	unsigned generation = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_startCond.wait(lock, [&] { return _quit || _generation != generation; });
+			if (_quit)
+				return;
+			generation = _generation;
+		}
+
+		computeChunk(index);
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			--_pending;
+		}
+		_doneCond.notify_one();
+	}
+}
@@ -0,0 +1,71 @@
+#ifndef __MCPLANE_TRANSFORM_HPP__
+# define __MCPLANE_TRANSFORM_HPP__
+
+# include <condition_variable>
+# include <mutex>
+# include <thread>
+# include <vector>
+# include <glm/glm.hpp>
+# include <glm/gtc/quaternion.hpp>
+# include "EntityStates.hpp"
+
+
+///
+/// translate(position) * mat4_cast(rotation) * scale(scale), built directly
+/// from the quaternion without intermediate matrices.
+///
+inline glm::mat4 	composeModelMatrix( const glm::vec3& p, const glm::quat& q, const glm::vec3& s )
+{
+	float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+	float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+	float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+	return glm::mat4(
+			(1.f - 2.f * (yy + zz)) * s.x, 2.f * (xy + wz) * s.x, 2.f * (xz - wy) * s.x, 0.f,
+			2.f * (xy - wz) * s.y, (1.f - 2.f * (xx + zz)) * s.y, 2.f * (yz + wx) * s.y, 0.f,
+			2.f * (xz + wy) * s.z, 2.f * (yz - wx) * s.z, (1.f - 2.f * (xx + yy)) * s.z, 0.f,
+			p.x, p.y, p.z, 1.f);
+}
+
+/// composeModelMatrix over arrays, four entities at a time when SSE is available.
+void 	computeModelMatrices( const glm::vec3* positions, const glm::quat* rotations,
+		const glm::vec3* scales, glm::mat4* out, size_t count );
+
+///
+/// Compute the model matrices of all the entities, split across worker
+/// threads above PARALLEL_THRESHOLD entities.
+///
+class TransformStage
+{
+	public:
+		static const size_t 	PARALLEL_THRESHOLD = 4096;
+
+		/// workers: threads in addition to the calling one, started on the
+		/// first compute() above PARALLEL_THRESHOLD.
+		explicit TransformStage( unsigned workers = defaultWorkers() );
+		~TransformStage( void );
+
+		void 	compute( const EntityStates& states, std::vector<glm::mat4>& matrices );
+
+		static unsigned 	defaultWorkers( void );
+
+	private:
+		void 	work( unsigned index );
+		void 	computeChunk( unsigned index );
+
+		unsigned 						_workers;
+		std::vector<std::thread> 		_threads;
+		std::mutex 						_mutex;
+		std::condition_variable 		_startCond;
+		std::condition_variable 		_doneCond;
+		unsigned 						_generation = 0;
+		unsigned 						_pending = 0;
+		bool 							_quit = false;
+
+		// current job
+		const EntityStates* 			_states = nullptr;
+		glm::mat4* 						_out = nullptr;
+};
+
+
+#endif // __MCPLANE_TRANSFORM_HPP__
@@ -2,9 +2,15 @@
 # include <map>
 # include <vector>
 # include <iostream>
-# include <chrono>
+# include <cstring>
+# include <string>
+# include <cmath>
 
 # include "Graphics.hpp"
+# include "Aero.hpp"
+# include "Telemetry.hpp"
+# include "StateExport.hpp"
+# include "Transform.hpp"
 # include <PxPhysicsAPI.h>
 
 
@@ -21,6 +27,8 @@ PxCooking*					gCooking = nullptr;
 PxPhysics*					gPhysics = nullptr;
 PxMaterial*					gPhysicsMaterial = nullptr;
 PxScene* 					gPhysicsScene = nullptr;
+Telemetry 					gTelemetry;
+StateExport 				gStateExport;
 
 const vec3 VEC3_ZERO = vec3(0.f, 0.f, 0.f);
 
@@ -29,12 +37,11 @@ struct Entity
 	vec3 			position 	= vec3(1.f, 1.f, 1.f);
 	quat 			rotation 	= quat(0.f, 0.f, 0.f, 1.f);
 	vec3 			scale 		= vec3(1.f, 1.f, 1.f);
+	MeshID 			mesh 		= 0; ///< box, see Graphics::getMesh
+	MaterialID 		material 	= 0; ///< see Graphics::addMaterial
 
 	mat4 			getModelMatrix( void ) {
-		mat4 model = mat4_cast(rotation);
-		model = model*glm::scale(mat4(1.f), scale);
-		model = glm::translate(mat4(1.f), position)*model;
-		return model;
+		return composeModelMatrix(position, rotation, scale);
 	};
 };
 
@@ -49,6 +56,7 @@ struct StaticEntity : public Entity
 };
 
 std::map<int, DynamicEntity> dynamicEntities;
+EntityStates 				dynamicStates; ///< SoA copy of dynamicEntities, refreshed each step
 
 physx::PxVec3 	toPxVec3( vec3 v ) { return physx::PxVec3(v.x, v.y, v.z); }
 physx::PxQuat 	toPxQuat( quat q ) { return physx::PxQuat(q.x, q.y, q.z, q.w); }
@@ -82,6 +90,7 @@ bool 	initPhysics( void )
 	sceneDesc.gravity = PxVec3(0.0f, -9.81f, 0.0f);
 	sceneDesc.cpuDispatcher	= gDispatcher;
 	sceneDesc.filterShader	= PxDefaultSimulationFilterShader;
+	sceneDesc.simulationEventCallback = &gTelemetry;
 	gPhysicsScene = gPhysics->createScene(sceneDesc);
 
 	return true;
@@ -157,6 +166,17 @@ void 	updateStates( void )
 }
 
 
+void 	gatherStates( EntityStates& states )
+{
+	states.clear();
+	for (auto& it : dynamicEntities)
+	{
+		const DynamicEntity& e = it.second;
+		states.push(it.first, e.position, e.rotation, e.scale);
+	}
+}
+
+
 StaticEntity* 	ground = nullptr;
 void 		initGround( vec3 halfsize, vec3 position )
 {
@@ -191,6 +211,8 @@ void 	addFixedJoint( int eidA, vec3 posA, int eidB, vec3 posB )
 	joint->setConstraintFlag( PxConstraintFlag::eCOLLISION_ENABLED, false );
 	entityA.body->setLinearVelocity(PxVec3(0, 0, 0));
 	entityA.body->setAngularVelocity(PxVec3(0, 0, 0));
+
+	gTelemetry.addJoint(joint, eidA, eidB);
 }
 
 PxRevoluteJoint* 	addRevoluteJoint( int eidA, vec3 posA, int eidB, vec3 posB )
@@ -224,6 +246,8 @@ PxRevoluteJoint* 	addRevoluteJoint( int eidA, vec3 posA, int eidB, vec3 posB )
 	joint->setDriveForceLimit(1000.f);
 	joint->setDriveVelocity(-100.f);
 
+	gTelemetry.addJoint(joint, eidA, eidB);
+
 	return joint;
 }
 
@@ -236,59 +260,65 @@ void 	scriptPropulsor( DynamicEntity& e, float power )
 	dyn.addForce(toPxVec3(force), PxForceMode::eFORCE);
 }
 
-void 	scriptWing( DynamicEntity& e, float _lift, float _drag )
+void 	scriptWing( DynamicEntity& e, const AeroProfile& profile )
 {
-	PxVec3 liftDir(0, 1, 0);
-
 	PxRigidDynamic& dyn = *e.body;
 
+	vec3 linearVel = toVec3(dyn.getLinearVelocity());
+	float velocity2 = dot(linearVel, linearVel);
+	if (velocity2 <= 0.f)
+		return;
+
 	// Parameters
 	quat rotation = e.rotation;
-	vec3 forwardDir = normalize(rotation * vec3(0, 0, -1));
-	vec3 upDir = normalize(rotation * vec3(0, 1, 0));
-	vec3 rightDir = normalize(rotation * vec3(1, 0, 0));
+	vec3 forwardDir = rotation * vec3(0, 0, -1);
+	vec3 upDir = rotation * vec3(0, 1, 0);
+	vec3 rightDir = rotation * vec3(1, 0, 0);
 
-	vec3 linearVel = toVec3(dyn.getLinearVelocity());
-	float velocity = length(linearVel);
-	vec3 linearDir = normalize(linearVel);
-	float atmosDensity = 1.225f; // kg/m3 (earth, sea level, 15°C)
-	float staticAirPressure = 101.325f; // Pa, or N/m2 (earth, sea level, see US Standard Atmosphere)
-	float cosAoa = dot(linearDir, forwardDir);
-	float cosStupidAoa = dot(linearDir, upDir);
+	vec3 linearDir = linearVel * inversesqrt(velocity2);
+	float area = e.scale.x * e.scale.z; // span * chord
+	float chord = e.scale.z;
+	float atmosDensity = Atmosphere::getDensity(e.position.y);
+	float aoa = std::atan2(-dot(linearDir, upDir), dot(linearDir, forwardDir));
 
 
 	// Equations:
-	// Lift = CrossProduct(velocity, wingRight) * Cos(StupidAoA) * (1 - Abs(Cos(StupidAoA))) * Cos(AoA) * deflectionLiftCoeff * StaticAirPressure;
-	// Drag = Abs(cos(StupidAoA))*NativeDragCoefficient;
+	// q = 0.5 * atmosDensity * pow(velocity, 2)
+	// Drag = -linearDir * q * area * Cd(AoA)
+	// Lift = CrossProduct(wingRight, linearDir) * q * area * Cl(AoA)
+	// Moment = wingRight * q * area * chord * Cm(AoA)
+	float qArea = 0.5f * atmosDensity * velocity2 * area;
 
 	//// Drag Force ////
-	// dragCoeff = Abs(cos(StupidAoA))*NativeDragCoefficient;
-	// Fdrag = 0.5 * atmosDensity  * pow(velocity, 2) * dragCoeff
-
-	float nativeDragCoeff = _drag;
-	float dragCoeff = abs(cosStupidAoa) * nativeDragCoeff;
-
-	float dragForce = 0.5f * atmosDensity * pow(velocity, 2.f) * dragCoeff;
-	PxVec3 drag = toPxVec3(-linearDir) * dragForce;
-	if (drag.magnitudeSquared() > 0.f)
-		dyn.addForce(drag, PxForceMode::eFORCE);
-
+	vec3 dragForce = -linearDir * (qArea * profile.drag(aoa));
+	dyn.addForce(toPxVec3(dragForce), PxForceMode::eFORCE);
 
 	//// Lift Force ////
-	// Lift = CrossProduct(velocity, wingRight) * Cos(StupidAoA) * (1 - Abs(Cos(StupidAoA))) * Cos(AoA) * deflectionLiftCoeff * StaticAirPressure;
-	// see simplified 2d graph: cos(x + pi/2) * (1 - abs(cos(x + pi/2))) * cos(x)
-
-	float liftCoeff = _lift;
-	vec3 liftForce = cross(linearVel, rightDir) * cosStupidAoa * (1.f - abs(cosStupidAoa)) * cosAoa * liftCoeff * staticAirPressure;
+	// perpendicular to the airflow and the span: vanishes when flying sideways
+	vec3 liftForce = cross(rightDir, linearDir) * (qArea * profile.lift(aoa));
+	dyn.addForce(toPxVec3(liftForce), PxForceMode::eFORCE);
 
-	if (length(liftForce) > 0.f)
-		dyn.addForce(toPxVec3(liftForce), PxForceMode::eFORCE);
+	//// Pitching Moment ////
+	vec3 moment = rightDir * (qArea * chord * profile.moment(aoa));
+	dyn.addTorque(toPxVec3(moment), PxForceMode::eFORCE);
 }
 
 
-int 	main ( void )
+int 	main ( int argc, char** argv )
 {
-	if (SDL_Init(SDL_INIT_EVERYTHING) < 0)
+	// --headless: no window, run as fast as possible, viewers attach to the shared state
+	// --joint-log <path>: write every joint force sample (off by default, grows fast)
+	bool headless = false;
+	std::string jointLogPath;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--headless") == 0)
+			headless = true;
+		else if (strcmp(argv[i], "--joint-log") == 0 && i + 1 < argc)
+			jointLogPath = argv[++i];
+	}
+
+	if (SDL_Init(headless ? SDL_INIT_EVENTS : SDL_INIT_EVERYTHING) < 0)
 	{
 		std::cerr << "failed to load SDL. (everything)";
 		return 1;
@@ -296,7 +326,7 @@ int 	main ( void )
 
 	Graphics graphics;
 
-	if (graphics.init(1280, 720) == false)
+	if (!headless && graphics.init(1280, 720) == false)
 		return 1;
 
 	if (initPhysics() == false)
@@ -329,50 +359,78 @@ int 	main ( void )
 	addEntityBox(112, 1.f, vec3(0.5f, 0.5f, 0.5f), VEC3_ZERO);
 	addFixedJoint(112, vec3(0.f, -2.f, 0.f), 315, vec3(0.f, 0.f, 0.f));
 
-	auto t0 = std::chrono::high_resolution_clock::now();
+	TransformStage transformStage;
+	DrawList drawList;
+
+	if (!headless)
+	{
+		MaterialID entityMaterial = graphics.addMaterial(Color(1.f, 0.2f, 0.2f));
+		for (auto& it : dynamicEntities)
+			it.second.material = entityMaterial;
+
+		MeshID wingMesh = graphics.getMesh(MeshKey::wing(24));
+		dynamicEntities[316].mesh = wingMesh;
+		dynamicEntities[320].mesh = wingMesh;
+		dynamicEntities[321].mesh = wingMesh;
+	}
+
+	const AeroProfile wingProfile = AeroProfile::flatPlate(1.f, 0.2f);
+	const AeroProfile elevatorProfile = AeroProfile::flatPlate(0.4f, 0.1f);
+
+	gTelemetry.start(jointLogPath); // empty: aggregate only
+	gStateExport.open("/mcplane_states", 1024);
+	uint32_t step = 0;
+
 	while (true)
 	{
 		SDL_Event 	ev;
-		SDL_PollEvent( &ev );
-		if (ev.type == SDL_QUIT || (ev.type == SDL_KEYDOWN && ev.key.keysym.sym == SDLK_ESCAPE))
+		if (SDL_PollEvent( &ev ) && (ev.type == SDL_QUIT || (ev.type == SDL_KEYDOWN && ev.key.keysym.sym == SDLK_ESCAPE)))
 			break;
 
-		auto t1 = std::chrono::high_resolution_clock::now();
-		if (std::chrono::duration<float>(t1-t0).count() > 1.f)
+		// simulated time, so that headless runs play the same scenario
+		if (step >= 60)
 		{
 			revoA->setDriveVelocity(0.f);
 			revoB->setDriveVelocity(0.f);
 		}
-		scriptWing(dynamicEntities[316], 10.f, 10.f);
-		scriptWing(dynamicEntities[320], 0.5f, 0.5f);
-		scriptWing(dynamicEntities[321], 0.5f, 0.5f);
+		scriptWing(dynamicEntities[316], wingProfile);
+		scriptWing(dynamicEntities[320], elevatorProfile);
+		scriptWing(dynamicEntities[321], elevatorProfile);
 		//scriptPropulsor(dynamicEntities[317], 1200.f);
 		scriptPropulsor(dynamicEntities[317], 720.f);
 
 		gPhysicsScene->simulate(1.f/60.f);
 		gPhysicsScene->fetchResults(true);
+		gTelemetry.collect();
 
 		updateStates();
+		gatherStates(dynamicStates);
+		gStateExport.publish(dynamicStates, step++);
+
+		if (headless)
+			continue;
 
 		graphics.clear();
 
 		// Ground
 		graphics.drawBox(ground->getModelMatrix(), Color(0.2f, 0.2f, 1.f));
 
-		auto it = dynamicEntities.begin();
-		while (it != dynamicEntities.end())
-		{
-			Entity& e = it->second;
-			graphics.drawBox(e.getModelMatrix(), Color(1.f, 0.2f, 0.2f));
-
-			++it;
-		}
+		// Dynamic entities, in the same order as dynamicStates
+		drawList.clear();
+		for (auto& it : dynamicEntities)
+			drawList.add(it.second.mesh, it.second.material);
+		transformStage.compute(dynamicStates, drawList.matrices);
+		drawList.sort();
+		graphics.submit(drawList);
 
 		graphics.refresh();
 		usleep(1000);
 	}
 
-	graphics.deinit();
+	gTelemetry.stop();
+	gStateExport.close();
+	if (!headless)
+		graphics.deinit();
 	deinitPhysics();
 
 	SDL_Quit();